@@ -0,0 +1,23 @@
+import os
+from os.path import join
+
+from setuptools import Extension, setup
+
+mkl = os.environ.get("MKLROOT", "/opt/intel/oneapi/mkl/latest")
+cx = os.environ.get("CXINCLUDE", "")  # Directory holding cx_math.h from the constexpr library
+
+setup(
+    name="zdf",
+    version="0.1",
+    ext_modules=[
+        Extension(
+            "zdf",
+            sources=[join("src", "pyzdf.cpp")],
+            include_dirs=[join(mkl, "include")] + ([cx] if cx else []),
+            library_dirs=[join(mkl, "lib"), join(mkl, "lib", "intel64")],
+            libraries=["mkl_rt"],
+            extra_compile_args=["-std=c++20", "-O3"],
+            language="c++",
+        )
+    ],
+)
@@ -0,0 +1,103 @@
+/**
+ * *****************************************************************************
+ * \file cascade.h
+ * \author Graham Beck
+ * \brief ZDF: Multirate cascade that feeds the decimated zeroth-derivative outputs of a fast
+ *                     ZDF into a second, slow ZDF, reaching long timescales without a long filter.
+ * \version 0.1
+ * \date 2025-12-01
+ *
+ * \copyright Copyright (c) 2025
+ * *****************************************************************************
+ */
+#pragma once
+
+#include <vector>
+
+#include "zdf.h"
+
+
+namespace zdf
+{
+    /**
+    * @brief A fast ZDF<T> decimated by R whose zeroth derivative at its mx'th mu timescale is the signal of a slow ZDF<U>.
+    *
+    * @details The slow filter's horizon is R*N_U fast observations, eg N_U=512 at R=100 spans 51200 of them.
+    *                  Its .zdft initialization file must accordingly hold decimated zeroth-derivative values,
+    *                  as written by tst/TestData.py when given U and R.
+    *                  Outputs are the kF_T fast derivatives followed by the kF_U slow ones.
+    */
+    template <zdf_t T, zdf_t U>
+    class Cascade
+    {
+        static_assert(zdfix::decode<zdfix::kD>(T) & 1, "The fast filter must return the zeroth derivative");
+        static_assert(T != U, "The fast and slow filters must persist to distinct .zdft files");
+
+      public:
+        static constexpr MKL_INT kFT = ZDF<T>::kF;
+        static constexpr MKL_INT kFU = ZDF<U>::kF;
+        static constexpr MKL_INT kF = kFT + kFU;
+
+        template<typename S>
+        Cascade(const S& from, const unsigned short decimation, const unsigned short mx = 0)
+            : _fast(from, decimation)
+            , _slow(from)
+            , _mx(mx)
+        {
+            if (_mx >= ZDF<T>::nM) { throw std::runtime_error("Invalid Cascade Timescale"); }
+            std::memcpy(_filtered, _fast.filtered(), kFT*sizeof(float));
+            std::memcpy(_filtered+kFT, _slow.filtered(), kFU*sizeof(float));
+        }
+
+        /**
+        * @brief Whether the last signal value produced fresh (decimated) outputs
+        */
+        bool due() const { return _fast.due(); }
+
+        /**
+        * @brief Perform the filtering for a new signal value, advancing the slow filter on each decimated output
+        */
+        const float(&update(const float& x))[kF] {
+            const float(&fast)[kFT] = _fast.update(x);
+            if (_fast.due()) {
+                std::memcpy(_filtered, fast, kFT*sizeof(float));
+                std::memcpy(_filtered+kFT, _slow.update(fast[_mx]), kFU*sizeof(float));
+            }
+            return _filtered;
+        }
+        /**
+        * @brief Block-evaluates B new signal values through both filters, writing a row of kF derivatives to out
+        *              for each decimated output point. Returns the number of rows written.
+        */
+        size_t update(const float* x, const size_t B, float* out) {
+            std::vector<float> fast((B/_fast.decimation()+1)*kFT);
+            const size_t J = _fast.update(x, B, fast.data());
+            if (J == 0) { return 0; }
+            std::vector<float> y0(J), slow(J*kFU);
+            for (size_t jx = 0; jx < J; ++jx) { y0[jx] = fast[jx*kFT+_mx]; }
+            _slow.update(y0.data(), J, slow.data());
+            for (size_t jx = 0; jx < J; ++jx) {
+                std::memcpy(out+jx*kF, fast.data()+jx*kFT, kFT*sizeof(float));
+                std::memcpy(out+jx*kF+kFT, slow.data()+jx*kFU, kFU*sizeof(float));
+            }
+            std::memcpy(_filtered, out+(J-1)*kF, kF*sizeof(float));
+            return J;
+        }
+
+        /**
+        * @brief Persist the updated observable series of both filters to file.
+        */
+        template<typename S>
+        void write(const S& to) {
+            _fast.write(to);
+            _slow.write(to);
+        }
+
+      private:
+        ZDF<T> _fast;
+        ZDF<U> _slow;
+        const unsigned short _mx;
+        float _filtered[kF];
+    };
+
+} // namespace zdf
@@ -0,0 +1,256 @@
+/**
+ * *****************************************************************************
+ * \file engine.h
+ * \author Graham Beck
+ * \brief ZDF: Runtime-encoded filtering. Dispatches a runtime encoding to a compile-time
+ *                     ZDF<T> for each of a list of 'hot' encodings, and to a generic
+ *                     runtime-sized filter for any other.
+ * \version 0.1
+ * \date 2025-12-01
+ *
+ * \copyright Copyright (c) 2025
+ * *****************************************************************************
+ */
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "zdf.h"
+
+
+namespace zdf
+{
+    /**
+    * @brief Rejects runtime encodings without a filter length, derivatives or mu timescales
+    */
+    inline zdf_t validated(const zdf_t T) {
+        if (zdfix::decode<zdfix::kN>(T) == 0 || zdfix::decode<zdfix::kD>(T) == 0 || zdfix::decode<zdfix::kU>(T) <= zdfix::decode<zdfix::kM>(T)) {
+            throw std::runtime_error("Invalid Encoding");
+        }
+        return T;
+    }
+
+    /**
+    * @brief The runtime counterpart of ZDF<T>: N, nD, nM and q are decoded from the encoding
+    *              on construction and the filter, history and outputs live on the heap.
+    */
+    class ZDFGeneric
+    {
+      public:
+       /**
+        * @brief Contructs a Zero Delay Filter of encoding T from a binary file containing the N signal values
+        *              used for initialization, found in directory 'from'. Outputs are evaluated on every decimation'th
+        *              signal value only. 
+        */
+        template<typename S>
+        ZDFGeneric(const zdf_t T, const S& from, const unsigned short decimation = 1)
+            : _T(validated(T))
+            , _N(zdfix::decode<zdfix::kN>(T))
+            , _kF(std::popcount(zdfix::decode<zdfix::kD>(T)) * (zdfix::decode<zdfix::kU>(T) - zdfix::decode<zdfix::kM>(T)))
+            , _X(new float[_N])
+            , _fir(new float[_N*_kF])
+            , _filtered(new float[_kF])
+            , _hx(0)
+            , _R(decimation)
+            , _rx(0)
+        {
+            if (_R == 0) { throw std::runtime_error("Invalid Decimation"); }
+            std::fstream f = open(from, SUFFIX, std::ios::in | std::ios::binary);
+            f.read(reinterpret_cast<char*>(_X.get()), _N*sizeof(float));
+            if (f.gcount() != static_cast<std::streamsize>(_N*sizeof(float))) {
+                throw std::runtime_error(join(std::string(from.data()), _T, SUFFIX));
+            }
+            f.close();
+
+            std::unique_ptr<float[]> working(new float[_N*wkx::N]);
+            kernel(_T, working.get(), _fir.get());
+
+            // Apply the filter to the initialization data
+            sgemv(&TRANSPOSED, &_N, &_kF, &ONEf, _fir.get(), &_N, _X.get(), &SINGLESTEP, &ZEROf, _filtered.get(), &SINGLESTEP);
+        }
+
+        MKL_INT N() const { return _N; }
+        MKL_INT kF() const { return _kF; }
+
+        /**
+        * @brief Perform the filtering for a new signal value, returning all nD derivatives at their nM mu timescales.
+        *              Between decimated outputs the signal value is only ingested and the last outputs are returned.
+        */
+        const float* update(const float& x) {
+            _X[_hx++] = x;
+            if (++_rx == _R) {
+                _rx = 0;
+                sgemv(&TRANSPOSED, &_hx, &_kF, &ONEf, _fir.get()+_N-_hx, &_N, _X.get(), &SINGLESTEP, &ZEROf, _filtered.get(), &SINGLESTEP);
+                if (_hx < _N) {
+                    const MKL_INT tx = _N-_hx;
+                    sgemv(&TRANSPOSED, &tx, &_kF, &ONEf, _fir.get(), &_N, _X.get()+_hx, &SINGLESTEP, &ONEf, _filtered.get(), &SINGLESTEP);
+                }
+            }
+            _hx %= _N;
+            return _filtered.get();
+        }
+        /**
+        * @brief Block-evaluates B new signal values, writing the kF derivatives of each decimated output point
+        *              as a row of out. Returns the number of rows written.
+        */
+        size_t update(const float* x, const size_t B, float* out) {
+            if (_hx > 0) { std::rotate(_X.get(), _X.get()+_hx, _X.get()+_N); _hx = 0; }
+            const MKL_INT J = block(_N, _kF, _R, _fir.get(), _X.get(), _rx, x, B, out);
+            if (J > 0) { std::memcpy(_filtered.get(), out+(J-1)*_kF, _kF*sizeof(float)); }
+            return J;
+        }
+        /**
+        * @brief Convenience/demonstration function that block-evaluates (up to P) rows in file 'from'.
+        */
+        template<size_t P, typename S>
+        void update(const S& from) {
+            std::fstream f = open(from, INPUT, std::ios::in | std::ios::binary);
+            std::vector<float> xs(P);
+            f.read(reinterpret_cast<char*>(xs.data()), P*sizeof(float));
+            xs.resize(f.gcount()/sizeof(float));
+            f.close();
+            std::vector<float> cache(xs.size()*_kF);
+            const size_t nUpdates = update(xs.data(), xs.size(), cache.data());
+            f = open(from, OUTPUT, std::ios::out | std::ios::binary);
+            f.write(reinterpret_cast<const char*>(cache.data()), nUpdates*_kF*sizeof(float));
+            f.close();
+        }
+
+        /**
+        * @brief Whether the last signal value produced fresh (decimated) outputs
+        */
+        bool due() const { return _rx == 0; }
+        MKL_INT decimation() const { return _R; }
+        /**
+        * @brief The number of outputs that the next B signal values will produce
+        */
+        size_t rows(const size_t B) const { return (_rx+B) / _R; }
+
+        /**
+        * @brief Persist the updated observable series to file.
+        */
+        template<typename S>
+        void write(const S& to) {
+            if (_hx > 0) { std::rotate(_X.get(), _X.get()+_hx, _X.get()+_N); _hx = 0; }
+            std::fstream f = open(to, SUFFIX, std::ios::out | std::ios::binary);
+            f.write(reinterpret_cast<const char*>(_X.get()), _N*sizeof(float));
+            f.close();
+        }
+
+      private:
+        template<typename S>
+        std::fstream open(const S& dir, const char* suffix, const std::ios::openmode mode) const {
+            const std::string path = join(std::string(dir.data()), _T, suffix);
+            std::fstream f(path, mode);
+            if (!f.is_open()) {
+                throw std::runtime_error(path);
+            }
+            return f;
+        }
+
+        const zdf_t _T;
+        const MKL_INT _N;
+        const MKL_INT _kF;
+        std::unique_ptr<float[]> _X;
+        std::unique_ptr<float[]> _fir;
+        std::unique_ptr<float[]> _filtered;
+        MKL_INT _hx;
+        const MKL_INT _R;
+        MKL_INT _rx;
+    };
+
+    /**
+    * @brief A filter whose encoding T is chosen at runtime, eg from the output of ./zdf -e.
+    *
+    * @details Each of the (distinct) hot encodings H is compiled into a ZDF<H> specialization; a runtime T
+    *                  matching one of them is served by it and any other T falls through to ZDFGeneric.
+    *                  Dispatch is a single std::visit per call, so prefer the batch update(x, B, out) on hot paths.
+    */
+    template <zdf_t... H>
+    class ZDFEngine
+    {
+      public:
+        using kernel_t = std::variant<ZDFGeneric, ZDF<H>...>;
+
+        template<typename S>
+        ZDFEngine(const zdf_t T, const S& from, const unsigned short decimation = 1)
+            : _T(validated(T))
+            , _kF(std::popcount(zdfix::decode<zdfix::kD>(T)) * (zdfix::decode<zdfix::kU>(T) - zdfix::decode<zdfix::kM>(T)))
+            , _kernel(dispatch<S, H...>(T, from, decimation))
+        {}
+
+        zdf_t encoding() const { return _T; }
+        MKL_INT N() const { return zdfix::decode<zdfix::kN>(_T); }
+        MKL_INT kF() const { return _kF; }
+        unsigned short nD() const { return std::popcount(zdfix::decode<zdfix::kD>(_T)); }
+        unsigned short nM() const { return zdfix::decode<zdfix::kU>(_T) - zdfix::decode<zdfix::kM>(_T); }
+        unsigned short q() const { return zdfix::decode<zdfix::kQ>(_T); }
+        /**
+        * @brief Whether the encoding is served by a compile-time ZDF<H> rather than the generic filter
+        */
+        bool specialized() const { return _kernel.index() > 0; }
+
+        /**
+        * @brief Whether the last signal value produced fresh (decimated) outputs
+        */
+        bool due() const {
+            return std::visit([](const auto& k) { return k.due(); }, _kernel);
+        }
+        MKL_INT decimation() const {
+            return std::visit([](const auto& k) { return k.decimation(); }, _kernel);
+        }
+        size_t rows(const size_t B) const {
+            return std::visit([B](const auto& k) { return k.rows(B); }, _kernel);
+        }
+
+        /**
+        * @brief Perform the filtering for a new signal value, returning all kF derivatives
+        */
+        const float* update(const float& x) {
+            return std::visit([&x](auto& k) -> const float* { return k.update(x); }, _kernel);
+        }
+        /**
+        * @brief Block-evaluates B new signal values, writing a (row-major) row of kF derivatives to out for each 
+        *              decimated output point. Returns the number of rows written, at most B.
+        */
+        size_t update(const float* x, const size_t B, float* out) {
+            return std::visit([x, B, out](auto& k) { return k.update(x, B, out); }, _kernel);
+        }
+        /**
+        * @brief Convenience/demonstration function that block-evaluates (up to P) rows in file 'from'.
+        */
+        template<size_t P, typename S>
+        void update(const S& from) {
+            std::visit([&from](auto& k) { k.template update<P>(from); }, _kernel);
+        }
+
+        /**
+        * @brief Persist the updated observable series to file.
+        */
+        template<typename S>
+        void write(const S& to) {
+            std::visit([&to](auto& k) { k.write(to); }, _kernel);
+        }
+
+      private:
+        template<typename S, zdf_t U, zdf_t... Us>
+        static kernel_t dispatch(const zdf_t T, const S& from, const unsigned short decimation) {
+            if (T == U) { return kernel_t(std::in_place_type<ZDF<U>>, from, decimation); }
+            return dispatch<S, Us...>(T, from, decimation);
+        }
+        template<typename S>
+        static kernel_t dispatch(const zdf_t T, const S& from, const unsigned short decimation) {
+            return kernel_t(std::in_place_type<ZDFGeneric>, T, from, decimation);
+        }
+
+        const zdf_t _T;
+        const MKL_INT _kF;
+        kernel_t _kernel;
+    };
+
+} // namespace zdf
@@ -0,0 +1,27 @@
+/**
+ * *****************************************************************************
+ * \file hot.h
+ * \author Graham Beck
+ * \brief ZDF: The 'hot' encodings compiled into ZDF<T> specializations, shared by the
+ *                     executable and the Python extension. 
+ * \version 0.1
+ * \date 2025-12-01
+ *
+ * \copyright Copyright (c) 2025
+ * *****************************************************************************
+ */
+#pragma once
+
+#include "engine.h"
+
+
+namespace zdf
+{
+    namespace hot {
+        static constexpr zdf_t T = zdfix::encode(512, {0,1,2}, 2, 0, 1, 2); // The executable's default encoding
+    } // namespace hot
+
+    // Encodings compiled into ZDF<.> specializations; any other runtime encoding is served generically
+    using Engine = ZDFEngine<hot::T>;
+
+} // namespace zdf
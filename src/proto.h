@@ -14,6 +14,7 @@
 
 #include <fstream>
 #include <stdexcept>
+#include <string>
 
 #include "constants.h"
 #include "types.h"
@@ -36,17 +37,18 @@ namespace zdf
       /**
         * @brief The Proto class establishes the persistence protocol, reading and writing to file
         *              for initialization / warmstarting of state. The constructor takes as argument the 
-        *              directory where zdf files are persisted. 
+        *              directory where zdf files are persisted, either as a compile-time std::array<char, .> 
+        *              or as a runtime std::string. 
         * 
         * @note The expected .zdf file is opened for reading by construction and must be closed 
         *               elsewhere once initialization has been completed. 
         */
-        template<size_t M>
-        explicit Proto(const std::array<char, M>& from)
-            : _from(join<T>(from, suffix<proto::kFCore>()).data(), std::ios::in | std::ios::binary)
+        template<typename S>
+        explicit Proto(const S& from)
+            : _from(path<proto::kFCore>(from).data(), std::ios::in | std::ios::binary)
         {
             if (!_from.is_open()) {
-                throw std::runtime_error(join<T>(from, suffix<proto::kFCore>()).data());
+                throw std::runtime_error(path<proto::kFCore>(from).data());
             }
         }
 
@@ -60,11 +62,11 @@ namespace zdf
         *                  On the other hand when called on the input data file (signaled by 
         *                  proto::kFIn) then reading is assumed. 
         */
-        template<size_t M, protix_t U=proto::kFCore>
-        void open(const std::array<char, M>& to) { 
-            _from.open(join<T>(to, suffix<U>()).data(), mode<U>());
+        template<protix_t U=proto::kFCore, typename S>
+        void open(const S& to) { 
+            _from.open(path<U>(to).data(), mode<U>());
             if (!_from.is_open()) {
-                throw std::runtime_error(join<T>(to, suffix<U>()).data());
+                throw std::runtime_error(path<U>(to).data());
             }
         }
 
@@ -84,6 +86,14 @@ namespace zdf
             return io<U>::set(*this, args...);
         }
 
+      /**
+        * @brief The path of the file of purpose U in directory 'dir'
+        */
+        template<protix_t U, size_t M>
+        auto path(const std::array<char, M>& dir) { return join<T>(dir, suffix<U>()); }
+        template<protix_t U>
+        std::string path(const std::string& dir) { return join(dir, T, suffix<U>()); }
+
       private:
         template<protix_t U>
         const char(&suffix())[std::size(zdf::SUFFIX)] { return zdf::SUFFIX; }
@@ -99,7 +109,7 @@ namespace zdf
         template<> struct io<proto::kFCore> {
             static bool get(Proto<T>& p, float(&X)[zdfix::decode<zdfix::kN>(T)]) {
                 p._from.read(reinterpret_cast<char*>(X), sizeof(X));
-                return true;
+                return p._from.gcount() == static_cast<std::streamsize>(sizeof(X));
             }
             static void set(Proto<T>& p, const float(&X)[zdfix::decode<zdfix::kN>(T)]) {
                 p._from.write(reinterpret_cast<const char*>(X), sizeof(X));
@@ -0,0 +1,298 @@
+/**
+ * *****************************************************************************
+ * \file pyzdf.cpp
+ * \author Graham Beck
+ * \brief ZDF: CPython extension filtering contiguous float32 buffers (eg NumPy arrays) in place
+ *                     of the .zdfi/.zdfo file round-trip.
+ * \version 0.1
+ * \date 2025-12-01
+ *
+ * \copyright Copyright (c) 2025
+ * *****************************************************************************
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <new>
+#include <string>
+
+#include "mkl_vml_defines.h"
+#include "mkl_vml_functions.h"
+
+#include "hot.h"
+
+namespace
+{
+    struct PyZDF {
+        PyObject_HEAD
+        zdf::Engine* engine;
+        PyThread_type_lock lock;
+    };
+
+    /**
+    * @brief Whether a buffer holds native float32 values
+    */
+    bool isFloat32(const Py_buffer& view) {
+        const char* format = view.format ? view.format : "B";
+        if (*format == '@' || *format == '=' || *format == (PY_BIG_ENDIAN ? '>' : '<')) { ++format; }
+        return view.itemsize == sizeof(float) && format[0] == 'f' && format[1] == '\0';
+    }
+
+    /**
+    * @brief Serializes filtering on a ZDF, waiting for the lock without holding the GIL
+    */
+    void acquire(PyZDF* self) {
+        if (!PyThread_acquire_lock(self->lock, NOWAIT_LOCK)) {
+            Py_BEGIN_ALLOW_THREADS
+            PyThread_acquire_lock(self->lock, WAIT_LOCK);
+            Py_END_ALLOW_THREADS
+        }
+    }
+
+    bool initialized(PyZDF* self) {
+        if (self->engine) { return true; }
+        PyErr_SetString(PyExc_RuntimeError, "Uninitialized ZDF");
+        return false;
+    }
+
+    PyObject* create(PyTypeObject* type, PyObject*, PyObject*) {
+        PyZDF* self = reinterpret_cast<PyZDF*>(type->tp_alloc(type, 0));
+        if (!self) { return nullptr; }
+        self->engine = nullptr;
+        self->lock = PyThread_allocate_lock();
+        if (!self->lock) {
+            Py_DECREF(self);
+            return PyErr_NoMemory();
+        }
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    void destroy(PyZDF* self) {
+        delete self->engine;
+        if (self->lock) { PyThread_free_lock(self->lock); }
+        Py_TYPE(self)->tp_free(reinterpret_cast<PyObject*>(self));
+    }
+
+    /**
+    * @brief ZDF(encoding, directory, decimation=1): Constructs the filter from ${directory}/${encoding}.zdft
+    */
+    int init(PyZDF* self, PyObject* args, PyObject* kwds) {
+        static const char* kwlist[] = {"encoding", "directory", "decimation", nullptr};
+        unsigned long long encoding; const char* directory; PyObject* R = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "Ks|O!", const_cast<char**>(kwlist), &encoding, &directory, &PyLong_Type, &R)) {
+            return -1;
+        }
+        int overflow = 0;
+        const long long decimation = R ? PyLong_AsLongLongAndOverflow(R, &overflow) : 1;
+        if (decimation == -1 && PyErr_Occurred()) { return -1; }
+        if (overflow || decimation < 1 || decimation > std::numeric_limits<unsigned short>::max()) {
+            PyErr_SetString(PyExc_ValueError, "decimation must lie in [1, 65535]");
+            return -1;
+        }
+        std::string dir(directory);
+        if (!dir.empty() && dir.back() != zdf::PATHSEP[0]) { dir += zdf::PATHSEP; }
+
+        acquire(self);
+        delete self->engine; self->engine = nullptr;
+        try {
+            self->engine = new zdf::Engine(encoding, dir, static_cast<unsigned short>(decimation));
+        } catch (const std::bad_alloc&) {
+            PyErr_NoMemory();
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+        }
+        PyThread_release_lock(self->lock);
+        return self->engine ? 0 : -1;
+    }
+
+    /**
+    * @brief filter(x, out=None): Filters the float32 buffer x, writing a row of kF derivatives per decimated output
+    *              point into out, or into a newly allocated (rows(len(x)), kF) NumPy array. Returns out.
+    */
+    PyObject* filter(PyZDF* self, PyObject* args, PyObject* kwds) {
+        static const char* kwlist[] = {"x", "out", nullptr};
+        PyObject* x; PyObject* out = Py_None;
+        if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", const_cast<char**>(kwlist), &x, &out)) { return nullptr; }
+
+        Py_buffer xv;
+        if (PyObject_GetBuffer(x, &xv, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) { return nullptr; }
+        if (!isFloat32(xv)) {
+            PyBuffer_Release(&xv);
+            PyErr_SetString(PyExc_TypeError, "x must be a contiguous float32 buffer");
+            return nullptr;
+        }
+        const size_t B = xv.len / sizeof(float);
+
+        acquire(self);
+        if (!initialized(self)) {
+            PyThread_release_lock(self->lock);
+            PyBuffer_Release(&xv);
+            return nullptr;
+        }
+        const size_t J = self->engine->rows(B);
+        const Py_ssize_t kF = self->engine->kF();
+        if (out == Py_None) {
+            PyObject* numpy = PyImport_ImportModule("numpy");
+            out = numpy ? PyObject_CallMethod(numpy, "empty", "((nn)s)", static_cast<Py_ssize_t>(J), kF, "float32") : nullptr;
+            Py_XDECREF(numpy);
+        } else {
+            Py_INCREF(out);
+        }
+
+        Py_buffer ov;
+        if (!out || PyObject_GetBuffer(out, &ov, PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            PyThread_release_lock(self->lock);
+            PyBuffer_Release(&xv);
+            Py_XDECREF(out);
+            return nullptr;
+        }
+        if (!isFloat32(ov) || static_cast<size_t>(ov.len) < J*kF*sizeof(float)) {
+            PyThread_release_lock(self->lock);
+            PyBuffer_Release(&ov);
+            PyBuffer_Release(&xv);
+            Py_DECREF(out);
+            PyErr_Format(PyExc_ValueError, "out must be a writable contiguous float32 buffer of at least %zu x %zd values", J, kF);
+            return nullptr;
+        }
+        const std::uintptr_t xb = reinterpret_cast<std::uintptr_t>(xv.buf);
+        const std::uintptr_t ob = reinterpret_cast<std::uintptr_t>(ov.buf);
+        if (xv.len > 0 && ov.len > 0 && xb < ob+ov.len && ob < xb+xv.len) {
+            PyThread_release_lock(self->lock);
+            PyBuffer_Release(&ov);
+            PyBuffer_Release(&xv);
+            Py_DECREF(out);
+            PyErr_SetString(PyExc_ValueError, "out must not overlap x");
+            return nullptr;
+        }
+
+        std::exception_ptr failure;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            self->engine->update(static_cast<const float*>(xv.buf), B, static_cast<float*>(ov.buf));
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        Py_END_ALLOW_THREADS
+
+        PyThread_release_lock(self->lock);
+        PyBuffer_Release(&ov);
+        PyBuffer_Release(&xv);
+        if (failure) {
+            Py_DECREF(out);
+            try {
+                std::rethrow_exception(failure);
+            } catch (const std::bad_alloc&) {
+                return PyErr_NoMemory();
+            } catch (const std::exception& e) {
+                PyErr_SetString(PyExc_RuntimeError, e.what());
+            } catch (...) {
+                PyErr_SetString(PyExc_RuntimeError, "Filtering Failed");
+            }
+            return nullptr;
+        }
+        return out;
+    }
+
+    /**
+    * @brief rows(B): The number of output rows that filtering the next B values will produce
+    */
+    PyObject* rows(PyZDF* self, PyObject* arg) {
+        const Py_ssize_t B = PyLong_AsSsize_t(arg);
+        if (B == -1 && PyErr_Occurred()) { return nullptr; }
+        if (B < 0) {
+            PyErr_SetString(PyExc_ValueError, "B must be non-negative");
+            return nullptr;
+        }
+        acquire(self);
+        PyObject* J = initialized(self) ? PyLong_FromSize_t(self->engine->rows(B)) : nullptr;
+        PyThread_release_lock(self->lock);
+        return J;
+    }
+
+    /**
+    * @brief write(directory): Persists the updated observable series to ${directory}/${encoding}.zdft
+    */
+    PyObject* persist(PyZDF* self, PyObject* arg) {
+        const char* directory = PyUnicode_AsUTF8(arg);
+        if (!directory) { return nullptr; }
+        std::string dir(directory);
+        if (!dir.empty() && dir.back() != zdf::PATHSEP[0]) { dir += zdf::PATHSEP; }
+
+        acquire(self);
+        if (!initialized(self)) {
+            PyThread_release_lock(self->lock);
+            return nullptr;
+        }
+        bool failed = false;
+        try {
+            self->engine->write(dir);
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+            failed = true;
+        }
+        PyThread_release_lock(self->lock);
+        if (failed) { return nullptr; }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* encoding(PyZDF* self, void*) { return initialized(self) ? PyLong_FromUnsignedLongLong(self->engine->encoding()) : nullptr; }
+    PyObject* length(PyZDF* self, void*) { return initialized(self) ? PyLong_FromLong(self->engine->N()) : nullptr; }
+    PyObject* outputs(PyZDF* self, void*) { return initialized(self) ? PyLong_FromLong(self->engine->kF()) : nullptr; }
+    PyObject* decimation(PyZDF* self, void*) { return initialized(self) ? PyLong_FromLong(self->engine->decimation()) : nullptr; }
+    PyObject* specialized(PyZDF* self, void*) { return initialized(self) ? PyBool_FromLong(self->engine->specialized()) : nullptr; }
+
+    PyMethodDef methods[] = {
+        {"filter", reinterpret_cast<PyCFunction>(reinterpret_cast<void(*)(void)>(filter)), METH_VARARGS | METH_KEYWORDS,
+            "filter(x, out=None): Filters the float32 buffer x into out, or a new (rows(len(x)), kF) array. Releases the GIL."},
+        {"rows", reinterpret_cast<PyCFunction>(rows), METH_O, "rows(B): The number of output rows produced by the next B values."},
+        {"write", reinterpret_cast<PyCFunction>(persist), METH_O, "write(directory): Persists the observable series to its .zdft file."},
+        {nullptr, nullptr, 0, nullptr}
+    };
+
+    PyGetSetDef getset[] = {
+        {"encoding", reinterpret_cast<getter>(encoding), nullptr, "The ZDF encoding", nullptr},
+        {"N", reinterpret_cast<getter>(length), nullptr, "The filter length", nullptr},
+        {"kF", reinterpret_cast<getter>(outputs), nullptr, "The number of derivatives per output row", nullptr},
+        {"decimation", reinterpret_cast<getter>(decimation), nullptr, "The number of signal values per output row", nullptr},
+        {"specialized", reinterpret_cast<getter>(specialized), nullptr, "Whether a compile-time specialization serves the encoding", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+
+    PyTypeObject PyZDFType = {
+        PyVarObject_HEAD_INIT(nullptr, 0)
+    };
+
+    PyModuleDef module = {
+        PyModuleDef_HEAD_INIT, "zdf", "Zero Delay Filter over float32 buffers", -1, nullptr
+    };
+
+} // namespace
+
+PyMODINIT_FUNC PyInit_zdf(void)
+{
+    vmlSetMode(VML_EP | VML_FTZDAZ_ON | VML_ERRMODE_DEFAULT);
+
+    PyZDFType.tp_name = "zdf.ZDF";
+    PyZDFType.tp_doc = "ZDF(encoding, directory, decimation=1): Zero Delay Filter initialized from ${directory}/${encoding}.zdft";
+    PyZDFType.tp_basicsize = sizeof(PyZDF);
+    PyZDFType.tp_flags = Py_TPFLAGS_DEFAULT;
+    PyZDFType.tp_new = create;
+    PyZDFType.tp_init = reinterpret_cast<initproc>(init);
+    PyZDFType.tp_dealloc = reinterpret_cast<destructor>(destroy);
+    PyZDFType.tp_methods = methods;
+    PyZDFType.tp_getset = getset;
+    if (PyType_Ready(&PyZDFType) < 0) { return nullptr; }
+
+    PyObject* m = PyModule_Create(&module);
+    if (!m) { return nullptr; }
+    Py_INCREF(&PyZDFType);
+    if (PyModule_AddObject(m, "ZDF", reinterpret_cast<PyObject*>(&PyZDFType)) < 0) {
+        Py_DECREF(&PyZDFType);
+        Py_DECREF(m);
+        return nullptr;
+    }
+    return m;
+}
@@ -15,6 +15,7 @@
 #include <array>
 #include <cstring>
 #include <cstdint>
+#include <string>
 
 constexpr uint32_t nCr(const unsigned short n, unsigned short r) {
     uint32_t x = 1;
@@ -64,6 +65,14 @@ constexpr auto join(const std::array<char, L>& prefix, const char (&postfix)[U])
     return joined;
 }
 
+/**
+* @brief Runtime counterpart of the above for a std::string prefix and an integer T 
+*               only known at runtime
+*/
+inline std::string join(const std::string& prefix, const size_t T, const char* postfix) {
+    return prefix + std::to_string(T) + postfix;
+}
+
 /**
 * @brief Realigns circular/ring buffers that are col-major matrices
 *              with U rows and L columns, given current head and tail indices. 
@@ -9,22 +9,30 @@
  * \copyright Copyright (c) 2025
  * *****************************************************************************
  */
-#include "zdf.h"
+#include "cascade.h"
+#include "hot.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <concepts>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream> 
 #include <string>
 #include <unistd.h>
+#include <vector>
 
 #include "mkl_service.h"
 #include "mkl_vml_defines.h"
 #include "mkl_vml_functions.h"
 
 constexpr auto REPO = join(".", zdf::PATHSEP, "dat", zdf::PATHSEP);
-constexpr auto T = zdf::zdfix::encode(512, {0,1,2}, 2, 0, 1, 2);
+constexpr auto T = zdf::hot::T;
+constexpr auto TC = zdf::zdfix::encode(256, {0,1}, 2, 0, 1, 2); // Slow filter fed by T in the cascade check (-c)
 
-constexpr char OPTS[] = "d:e:in:t:w";
+constexpr char OPTS[] = "b:c:d:e:in:r:t:wz:";
 constexpr char OPTSEP = ',';
 
 template <typename U>
@@ -40,15 +48,144 @@ U next(std::stringstream& ss) {
     }
 }
 
+/**
+* @brief The decimation given on the command line, rejected outside [1, 65535] rather than wrapped
+*/
+unsigned short parseDecimation(const char* arg) {
+    const long long R = std::stoll(arg);
+    if (R < 1 || R > std::numeric_limits<unsigned short>::max()) { throw std::runtime_error("Invalid Decimation"); }
+    return static_cast<unsigned short>(R);
+}
+
+constexpr float GENERICFACTOR = 1.25f; // Tolerated slowdown of the generic path relative to ZDF<T>
+constexpr int BENCHROUNDS = 5;         // Alternated timing rounds, of which the fastest is reported
+
+/**
+* @brief Mean nanoseconds per update over reps passes of the observations xs
+*/
+template<typename Z>
+double nsPerUpdate(Z& z, const std::vector<float>& xs, const int reps, float& sink) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int rx = 0; rx < reps; ++rx) {
+        for (const float& x : xs) { sink += z.update(x)[0]; }
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (reps*xs.size());
+}
+
+/**
+* @brief Mean nanoseconds per value of block-evaluating reps passes of the observations xs
+*/
+template<typename Z>
+double nsPerBlockUpdate(Z& z, const std::vector<float>& xs, const int reps, float& sink) {
+    std::vector<float> out(xs.size()*Z::kF);
+    const auto start = std::chrono::steady_clock::now();
+    for (int rx = 0; rx < reps; ++rx) {
+        z.update(xs.data(), xs.size(), out.data());
+        sink += out[0];
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (reps*xs.size());
+}
+
+/**
+* @brief The observations in the .zdfi file of T
+*/
+std::vector<float> observations() {
+    std::vector<float> xs;
+    std::ifstream f(join(std::string(REPO.data()), T, zdf::INPUT), std::ios::in | std::ios::binary);
+    for (float x; f.read(reinterpret_cast<char*>(&x), sizeof(float)); ) { xs.push_back(x); }
+    if (xs.empty()) { throw std::runtime_error("No Observations"); }
+    return xs;
+}
+
+/**
+* @brief Runs the .zdfi observations through a Cascade<T, TC> decimated by R both online and as a block, 
+*              reporting the number of decimated outputs and the largest discrepancy between the two paths
+*/
+void cascade(const unsigned short R) {
+    using C = zdf::Cascade<T, TC>;
+    const std::vector<float> xs = observations();
+
+    C block(REPO, R);
+    std::vector<float> out(xs.size()*C::kF);
+    const size_t J = block.update(xs.data(), xs.size(), out.data());
+
+    C online(REPO, R);
+    float discrepancy = 0; size_t jx = 0;
+    for (const float& x : xs) {
+        const float(&filtered)[C::kF] = online.update(x);
+        if (online.due()) {
+            for (MKL_INT fx = 0; fx < C::kF; ++fx) { discrepancy = std::max(discrepancy, std::fabs(filtered[fx] - out[jx*C::kF+fx])); }
+            ++jx;
+        }
+    }
+    std::cout << "Cascade<" << T << ", " << TC << "> Outputs: " << J << " Block, " << jx << " Online" << std::endl;
+    std::cout << "Max Online/Block Discrepancy: " << discrepancy << std::endl;
+}
+
+/**
+* @brief Times the compile-time ZDF<T> against its dispatch through Engine and through the generic path,
+*              and its online updates against block evaluation of the same observations.
+* 
+* @details Each filter gets an untimed warm-up pass, then the four are timed in rotating order over 
+*                  BENCHROUNDS rounds and the fastest round of each is reported, so that no filter systematically 
+*                  absorbs cold caches or page faults.
+*/
+void benchmark(const int reps) {
+    if (reps < 1) { throw std::runtime_error("Invalid Repetitions"); }
+    const std::vector<float> xs = observations();
+
+    float sink = 0;
+    zdf::ZDF<T> compiled(REPO);
+    zdf::Engine specialized(T, REPO);
+    zdf::ZDFEngine<> generic(T, REPO);
+    zdf::ZDF<T> blocked(REPO);
+    nsPerUpdate(compiled, xs, 1, sink);
+    nsPerUpdate(specialized, xs, 1, sink);
+    nsPerUpdate(generic, xs, 1, sink);
+    nsPerBlockUpdate(blocked, xs, 1, sink);
+
+    double best[4] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), 
+                              std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    for (int rx = 0; rx < BENCHROUNDS; ++rx) {
+        for (int ox = 0; ox < 4; ++ox) {
+            switch ((rx+ox) % 4) {
+              case 0: best[0] = std::min(best[0], nsPerUpdate(compiled, xs, reps, sink)); break;
+              case 1: best[1] = std::min(best[1], nsPerUpdate(specialized, xs, reps, sink)); break;
+              case 2: best[2] = std::min(best[2], nsPerUpdate(generic, xs, reps, sink)); break;
+              case 3: best[3] = std::min(best[3], nsPerBlockUpdate(blocked, xs, reps, sink)); break;
+            }
+        }
+    }
+    const double tc = best[0], ts = best[1], tg = best[2], tb = best[3];
+
+    std::cout << "ZDF<" << T << "> ns/update: " << tc << std::endl;
+    std::cout << "Specialized Engine ns/update: " << ts << " (x" << ts/tc << ")" << std::endl;
+    std::cout << "Generic Engine ns/update: " << tg << " (x" << tg/tc << ", tolerance x" << GENERICFACTOR << ")" << std::endl;
+    if (tg > GENERICFACTOR*tc) { std::cout << "Generic path exceeds tolerance" << std::endl; }
+    std::cout << "ZDF<" << T << "> Block ns/update: " << tb << " (x" << tb/tc << ")" << std::endl;
+    if (tb > tc) { std::cout << "Block evaluation is slower than online updates" << std::endl; }
+    std::cout << "Checksum: " << sink << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     vmlSetMode(VML_EP | VML_FTZDAZ_ON | VML_ERRMODE_DEFAULT);  
 
      int opt;
     bool write = false;
+    zdf::zdf_t encoding = T;
+    unsigned short decimation = 1;
 
     while ((opt = getopt(argc, argv, OPTS)) != -1) {
         switch (opt) {
+          case 'b':
+            benchmark(std::stoi(optarg));
+            return 0;
+          case 'c':
+            cascade(parseDecimation(optarg));
+            return 0;
           case 'd': {
             std::stringstream ss(optarg);
             std::string token; unsigned short denc = 0;
@@ -77,16 +214,22 @@ int main(int argc, char *argv[])
             std::cout << "Minimum Second-Derivative-Based Filter Length: " << zdf::ZDF<T>::d2N(next<float>(ss), next<float>(ss)) << std::endl;
             return 0;
           }
+          case 'r':
+            decimation = parseDecimation(optarg);
+            break;
           case 't':
             mkl_set_num_threads(std::stoi(optarg));
             break;
           case 'w':
             write = true;
             break;
+          case 'z':
+            encoding = std::stoull(optarg);
+            break;
         }
     }
 
-    zdf::ZDF<T> zdf(REPO);
+    zdf::Engine zdf(encoding, REPO, decimation);
 
     zdf.update<256>(REPO);
 
@@ -17,6 +17,7 @@
 #include <bit>
 #include <climits>
 #include <utility>
+#include <vector>
 
 #include "cx_math.h"
 #include "mkl_blas.h"
@@ -40,6 +41,167 @@ namespace zdf
         static const wkx_t N         = kTauMx + 1;
     } // namespace wkx
 
+    static constexpr unsigned short kDMax = std::popcount(zdfix::kDMask);                        // Most derivatives encodable
+    static constexpr unsigned short kQMax = (zdfix::kQMask >> zdfix::kQShift) + 1;      // Largest Q-hull system
+    static constexpr MKL_INT kPhaseMin = 16;                                                     // Decimations below which windows are gathered
+    static constexpr MKL_INT kPanel = 1 << 16;                                                   // Floats of gathered windows per sgemm
+
+    /**
+    * @brief Generate the minimal filter of length N for derivative order n and shape parameters (kappa, mu), 
+    *              accumulating it, weighted by lambda, into out
+    */
+    inline void h(const MKL_INT N, const unsigned short n, const unsigned short kappa, const unsigned short mu, const float& lambda, float* wkg, float* out) {
+        const auto gamma = (lambda*((mu+n+1)*nCr(kappa+mu+2*n+1, kappa+n))) / N;
+        float w =1;
+        for (unsigned short ix = 1; ix <= n; ++ix) { w *= (kappa + ix); }
+        for (unsigned short ix = 0; ix <= n; ++ix) {
+            vsPowx(N, wkg+N*wkx::kTaux, kappa+ix, wkg+N*wkx::kTauKx);
+            vsSubI(N, &ONEf, NOSTEP, wkg+N*wkx::kTaux, SINGLESTEP, wkg+N*wkx::kTauMx, SINGLESTEP);
+            vsPowx(N, wkg+N*wkx::kTauMx, mu+n-ix, wkg+N*wkx::kTauMx);
+            vsMul(N, wkg+N*wkx::kTauKx, wkg+N*wkx::kTauMx, wkg+N*wkx::kTauKx);
+            const float c = (ix%2 ? -w : w) * nCr(n, ix) * gamma;
+            saxpy(&N, &c, wkg+N*wkx::kTauKx, &SINGLESTEP, out, &SINGLESTEP);
+            w *= static_cast<float>(mu+n-ix) / (kappa + ix+1); 
+        }
+    }
+
+    /**
+    * @brief Contructs the nD*nM normalized filters of encoding T into the col-major N x kF matrix fir. 
+    * 
+    * @details All sizes are taken from the runtime value of T so that the compile-time ZDF<T> and the 
+    *                  runtime ZDFEngine share one construction. The working buffer must hold N*wkx::N floats.
+    */
+    inline void kernel(const zdf_t T, float* working, float* fir) {
+        const MKL_INT N = zdfix::decode<zdfix::kN>(T);
+        const unsigned short nD = std::popcount(zdfix::decode<zdfix::kD>(T));
+        const unsigned short nM = zdfix::decode<zdfix::kU>(T) - zdfix::decode<zdfix::kM>(T);
+        const unsigned short d0 = std::countr_zero(zdfix::decode<zdfix::kD>(T));
+        const unsigned short q = zdfix::decode<zdfix::kQ>(T);
+        const unsigned short kappa = zdfix::decode<zdfix::kK>(T);
+
+        std::memset(fir, 0, N*nD*nM*sizeof(float));
+
+        std::fill(working+N*wkx::kOnex, working+N*(wkx::kOnex+1), 1);
+        for (unsigned short ix = 0; ix < N; ++ix ) {working[N*wkx::kTaux+ix] = N-ix-1; }
+        const float n = static_cast<float>(N);
+        vsDivI(N, working+N*wkx::kTaux, SINGLESTEP, &n, NOSTEP, working+N*wkx::kTaux, SINGLESTEP);
+
+        float lmbd[kQMax];
+
+        float derivs[kDMax]; derivs[0] = d0;
+        const unsigned short de = sizeof(zdf_t)*CHAR_BIT - std::countl_zero(zdfix::decode<zdfix::kD>(T));
+        for (unsigned short dx = d0+1, ix = 1; dx < de; ++dx) {
+            if ((zdfix::decode<zdfix::kD>(T) >> dx) & 1) {
+                derivs[ix++] = dx;
+            }
+        }
+
+        for (unsigned short nj = 0; nj < nD; ++nj) {
+            const unsigned short nx = derivs[nj];
+            for (unsigned short mj = 0; mj < nM; ++mj) {
+                const unsigned short mx = zdfix::decode<zdfix::kM>(T) + mj;
+                const unsigned short fx = mj+nM*nj;
+                float Z;
+
+                std::memset(lmbd, 0, q*sizeof(float)); lmbd[q] = 1.0f;
+                float* const firx = fir+N*fx;
+                // Get the minimal filter
+                h(N, nx, kappa, mx, lmbd[q], working, firx);
+                // Get the normalizing term for the minimal filter
+                if (nx > 0) { 
+                    Z = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP) / N;
+                    vsSubI(N, firx, SINGLESTEP, &Z, NOSTEP, firx, SINGLESTEP);
+                    vsAbs(N, firx, working+N*wkx::kTauMx);
+                    Z = sdot(&N, working+N*wkx::kTauMx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
+                } else {
+                    Z = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
+                }
+
+                if (q > 0) {
+                    // Solve for the Q-hull coefficients lambda
+                    const MKL_INT nq = q+1;
+                    float gram[kQMax*kQMax];
+                    const float c = 1.0f / nCr(mx+kappa+2*(nx+q)+1, q);
+                    for (unsigned short ix = 0; ix <= q; ++ix) {
+                        for (unsigned short jx = 0; jx <= q; ++jx) {
+                            gram[ix+nq*jx] = c*nCr(mx+nx+ix+jx, mx+nx+jx);
+                            gram[ix+nq*jx] *= nCr(kappa+nx+2*q-ix-jx, kappa+nx+q-jx);
+                        }
+                    }
+                    MKL_INT ipiv[kQMax]; MKL_INT outcome;
+                    sgesv(&nq, &SINGLESTEP, gram, &nq, ipiv, lmbd, &nq, &outcome);
+
+                    // Add together the non-minimal components
+                    std::memset(firx, 0, N*sizeof(float));
+                    for (unsigned short ix = 0; ix <= q; ++ix) {
+                        h(N, nx, kappa+q-ix, mx+ix, lmbd[ix], working, firx);
+                    }
+                    // Calculate the normalization
+                    if (nx > 0) { 
+                        const float z = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP) / N;
+                        vsSubI(N, firx, SINGLESTEP, &z, NOSTEP, firx, SINGLESTEP);
+                        vsAbs(N, firx, working+N*wkx::kTauMx);
+                        Z /= sdot(&N, working+N*wkx::kTauMx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
+                    } else {
+                        Z /= sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
+                    }
+                } else {
+                    Z = 1/Z;
+                }
+                vsMulI(N, firx, SINGLESTEP, &Z, NOSTEP, firx, SINGLESTEP);
+            }
+        }
+    }
+
+    /**
+    * @brief Polyphase evaluation of J outputs spaced R observations apart into the col-major kF x J matrix out.
+    * 
+    * @details x points at the oldest observation of the first output's window, so that the j'th window starts at
+    *                  x+j*R. Viewed as a col-major matrix with R rows, those windows are runs of consecutive columns and 
+    *                  each R-row phase block of the filter contributes a single sgemm over all J outputs.
+    *                  Below kPhaseMin those sgemms degenerate towards rank-1 updates, so the windows are instead 
+    *                  gathered into N x J panels (of at most kPanel floats) that each take one sgemm over the full filter.
+    */
+    inline void polyphase(const MKL_INT N, const MKL_INT kF, const MKL_INT R, const float* fir, const float* x, const MKL_INT J, float* out) {
+        if (R < kPhaseMin) {
+            const MKL_INT P = std::min(J, std::max<MKL_INT>(1, kPanel / N));
+            std::vector<float> W(static_cast<size_t>(N)*P);
+            for (MKL_INT jx = 0; jx < J; jx += P) {
+                const MKL_INT nj = std::min(P, J-jx);
+                for (MKL_INT wx = 0; wx < nj; ++wx) { std::memcpy(W.data()+wx*N, x+(jx+wx)*R, N*sizeof(float)); }
+                sgemm(&TRANSPOSED, &UNTRANSPOSED, &kF, &nj, &N, &ONEf, fir, &N, W.data(), &N, &ZEROf, out+jx*kF, &kF);
+            }
+            return;
+        }
+        for (MKL_INT mx = 0; mx < N; mx += R) {
+            const MKL_INT k = std::min(R, N-mx);
+            sgemm(&TRANSPOSED, &UNTRANSPOSED, &kF, &J, &k, &ONEf, fir+mx, &N, x+mx, &R, mx ? &ONEf : &ZEROf, out, &kF);
+        }
+    }
+
+    /**
+    * @brief Block-evaluates the B signal values x that follow the (oldest-first) history X of length N, given that rx 
+    *              values have been ingested since the last output. Writes the kF x J decimated outputs to out and 
+    *              advances X and rx past x, returning J. 
+    * 
+    * @details Only windows that reach back into X are evaluated over an N-sized scratch join of X and x; 
+    *                  all others are evaluated in place over x. 
+    */
+    inline MKL_INT block(const MKL_INT N, const MKL_INT kF, const MKL_INT R, const float* fir, float* X, MKL_INT& rx, const float* x, const size_t B, float* out) {
+        const MKL_INT J = (rx+B) / R;
+        const MKL_INT s0 = R-rx; // Window start of the first output, counting from X
+        const size_t nb = std::min<size_t>(B, N);
+        std::vector<float> b(N+nb);
+        std::memcpy(b.data(), X, N*sizeof(float));
+        std::memcpy(b.data()+N, x, nb*sizeof(float));
+        const MKL_INT Jb = s0 < N ? std::min(J, (N-s0+R-1) / R) : 0;
+        if (Jb > 0) { polyphase(N, kF, R, fir, b.data()+s0, Jb, out); }
+        if (J > Jb) { polyphase(N, kF, R, fir, x+s0+Jb*R-N, J-Jb, out+Jb*kF); }
+        std::memcpy(X, B < static_cast<size_t>(N) ? b.data()+B : x+B-N, N*sizeof(float));
+        rx = (rx+B) % R;
+        return J;
+    }
+
     template <zdf_t T>
     class ZDF
     {
@@ -73,131 +235,94 @@ namespace zdf
         }
         static constexpr unsigned short kDelay = static_cast<unsigned short>(N * delay(d0, zdfix::decode<zdfix::kK>(T), zdfix::decode<zdfix::kM>(T)));                                               
        /**
-        * @brief Contructs a Zero Delay Filter from a binary file containing the N signal values used for initialization
+        * @brief Contructs a Zero Delay Filter from a binary file containing the N signal values used for initialization.
+        *              Outputs are evaluated on every decimation'th signal value only. 
         */
-        template<size_t M>
-        ZDF(const std::array<char, M>& from)
+        template<typename S>
+        ZDF(const S& from, const unsigned short decimation = 1)
             : _proto(from)
             , _hx(0)
+            , _R(decimation)
+            , _rx(0)
         {
-            _proto.template get<proto::kFCore>(_X);
-            _proto.close();
-
-            std::memset(_fir, 0, N*kF*sizeof(float));
+            if (_R == 0) { throw std::runtime_error("Invalid Decimation"); }
 
-            float working[N*wkx::N];
-            std::fill(working+N*wkx::kOnex, working+N*(wkx::kOnex+1), 1);
-            for (unsigned short ix = 0; ix < N; ++ix ) {working[N*wkx::kTaux+ix] = N-ix-1; }
-            const float n = static_cast<float>(N);
-            vsDivI(N, working+N*wkx::kTaux, SINGLESTEP, &n, NOSTEP, working+N*wkx::kTaux, SINGLESTEP);
-
-            constexpr unsigned short q = zdfix::decode<zdfix::kQ>(T);
-            float lmbd[q+1];
-
-            float derivs[nD]; derivs[0] = d0;
-            const unsigned short de = sizeof(zdf_t)*CHAR_BIT - std::countl_zero(zdfix::decode<zdfix::kD>(T));
-            for (unsigned short dx = d0+1, ix = 1; dx < de; ++dx) {
-                if ((zdfix::decode<zdfix::kD>(T) >> dx) & 1) {
-                    derivs[ix++] = dx;
-                }
+            if (!_proto.template get<proto::kFCore>(_X)) {
+                throw std::runtime_error(_proto.template path<proto::kFCore>(from).data());
             }
+            _proto.close();
 
-            for (unsigned short nj = 0; nj < nD; ++nj) {
-                const unsigned short nx = derivs[nj];
-                for (unsigned short mj = 0; mj < nM; ++mj) {
-                    const unsigned short mx = zdfix::decode<zdfix::kM>(T) + mj;
-                    const unsigned short fx = mj+nM*nj;
-
-                    std::memset(lmbd, 0, q*sizeof(float)); lmbd[q] = 1.0f;
-                    float* const firx = _fir+N*fx;
-                    // Get the minimal filter
-                    h(nx, zdfix::decode<zdfix::kK>(T), mx, lmbd[q], working, reinterpret_cast<float(&)[N]>(*firx));
-                    // Get the normalizing term for the minimal filter
-                    if (nx > 0) { 
-                        _filtered[fx] = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP) / N;
-                        vsSubI(N, firx, SINGLESTEP, _filtered+fx, NOSTEP, firx, SINGLESTEP);
-                        vsAbs(N, firx, working+N*wkx::kTauMx);
-                        _filtered[fx] = sdot(&N, working+N*wkx::kTauMx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
-                    } else {
-                        _filtered[fx] = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
-                    }
-
-                    if constexpr (q > 0) {
-                        // Solve for the Q-hull coefficients lambda
-                        constexpr MKL_INT nq = q+1;
-                        float gram[nq*nq];
-                        const float c = 1.0f / nCr(mx+zdfix::decode<zdfix::kK>(T)+2*(nx+q)+1, q);
-                        for (unsigned short ix = 0; ix <= q; ++ix) {
-                            for (unsigned short jx = 0; jx <= q; ++jx) {
-                                gram[ix+nq*jx] = c*nCr(mx+nx+ix+jx, mx+nx+jx);
-                                gram[ix+nq*jx] *= nCr(zdfix::decode<zdfix::kK>(T)+nx+2*q-ix-jx, zdfix::decode<zdfix::kK>(T)+nx+q-jx);
-                            }
-                        }
-                        MKL_INT ipiv[nq]; MKL_INT outcome;
-                        sgesv(&nq, &SINGLESTEP, gram, &nq, ipiv, lmbd, &nq, &outcome);
+            float working[N*wkx::N];
+            kernel(T, working, _fir);
 
-                        // Add together the non-minimal components
-                        std::memset(firx, 0, N*sizeof(float));
-                        for (unsigned short ix = 0; ix <= q; ++ix) {
-                            h(nx, zdfix::decode<zdfix::kK>(T)+q-ix, mx+ix, lmbd[ix], working, reinterpret_cast<float(&)[N]>(*firx));
-                        }
-                        // Calculate the normalization
-                        if (nx > 0) { 
-                            const float Z = sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP) / N;
-                            vsSubI(N, firx, SINGLESTEP, &Z, NOSTEP, firx, SINGLESTEP);
-                            vsAbs(N, firx, working+N*wkx::kTauMx);
-                            _filtered[fx] /= sdot(&N, working+N*wkx::kTauMx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
-                        } else {
-                            _filtered[fx] /= sdot(&N, firx, &SINGLESTEP, working+N*wkx::kOnex, &SINGLESTEP);
-                        }
-                    } else {
-                        _filtered[fx] = 1/_filtered[fx];
-                    }
-                    vsMulI(N, firx, SINGLESTEP, _filtered+fx, NOSTEP, firx, SINGLESTEP);
-                }
-            }
             // Apply the filter to the initialization data
             sgemv(&TRANSPOSED, &N, &kF, &ONEf, _fir, &N, _X, &SINGLESTEP, &ZEROf, _filtered, &SINGLESTEP);
         }
 
         /**
-        * @brief Perform the filtering for a new signal value, returning all nD derivatives at their nM mu timescales
+        * @brief Perform the filtering for a new signal value, returning all nD derivatives at their nM mu timescales.
+        *              Between decimated outputs the signal value is only ingested and the last outputs are returned.
         */
         const float(&update(const float& x))[kF] {
             _X[_hx++] = x;
-            sgemv(&TRANSPOSED, &_hx, &kF, &ONEf, _fir+N-_hx, &N, _X, &SINGLESTEP, &ZEROf, _filtered, &SINGLESTEP);
-            if (_hx < N) {
-                const MKL_INT tx = N-_hx;
-                sgemv(&TRANSPOSED, &tx, &kF, &ONEf, _fir, &N, _X+_hx, &SINGLESTEP, &ONEf, _filtered, &SINGLESTEP);
+            if (++_rx == _R) {
+                _rx = 0;
+                sgemv(&TRANSPOSED, &_hx, &kF, &ONEf, _fir+N-_hx, &N, _X, &SINGLESTEP, &ZEROf, _filtered, &SINGLESTEP);
+                if (_hx < N) {
+                    const MKL_INT tx = N-_hx;
+                    sgemv(&TRANSPOSED, &tx, &kF, &ONEf, _fir, &N, _X+_hx, &SINGLESTEP, &ONEf, _filtered, &SINGLESTEP);
+                }
             }
             _hx %= N;
             return _filtered;
         }
         /**
-        * @brief Convenience/demonstration function that performs all online updates from the rows in file 'from'. 
+        * @brief Block-evaluates B new signal values, writing the kF derivatives of each decimated output point 
+        *              as a row of out. Returns the number of rows written.
         */
-        template<size_t P, size_t M>
-        void update(const std::array<char, M>& from) { 
-            _proto.template open<M, proto::kFIn>(from);
-            float x; float cache[P*kF]; float* cachex = cache;
-            while(_proto.template get<proto::kFIn>(x)) {
-                std::memcpy(cachex, update(x), kF*sizeof(float));
-                cachex += kF;
-            }
+        size_t update(const float* x, const size_t B, float* out) {
+            if (_hx > 0) { std::rotate(_X, _X+_hx, _X+N); _hx = 0; }
+            const MKL_INT J = block(N, kF, _R, _fir, _X, _rx, x, B, out);
+            if (J > 0) { std::memcpy(_filtered, out+(J-1)*kF, kF*sizeof(float)); }
+            return J;
+        }
+        /**
+        * @brief Convenience/demonstration function that block-evaluates (up to P) rows in file 'from'. 
+        */
+        template<size_t P, typename S>
+        void update(const S& from) { 
+            _proto.template open<proto::kFIn>(from);
+            float xs[P]; size_t nx = 0;
+            while(nx < P && _proto.template get<proto::kFIn>(xs[nx])) { ++nx; }
             _proto.close();
-            const size_t nUpdates = (cachex - cache) / kF;
-            _proto.template open<M, proto::kFOut>(from);
+            float cache[P*kF];
+            const size_t nUpdates = update(xs, nx, cache);
+            _proto.template open<proto::kFOut>(from);
             for (size_t ix = 0; ix < nUpdates; ++ix) {
                 _proto.template set<proto::kFOut>(reinterpret_cast<float(&)[kF]>(cache[ix*kF]));
             }
             _proto.close();
         }
 
+        /**
+        * @brief Whether the last signal value produced fresh (decimated) outputs
+        */
+        bool due() const { return _rx == 0; }
+        MKL_INT decimation() const { return _R; }
+        /**
+        * @brief The number of outputs that the next B signal values will produce
+        */
+        size_t rows(const size_t B) const { return (_rx+B) / _R; }
+        /**
+        * @brief The most recent outputs
+        */
+        const float(&filtered() const)[kF] { return _filtered; }
+
         /**
         * @brief Persist the updated observable series to file. 
         */
-        template<size_t M>
-        void write(const std::array<char, M>& to) {
+        template<typename S>
+        void write(const S& to) {
             if (_hx > 0) { rectify<1, N>(_X, _hx, _hx); _hx = 0; }
             _proto.open(to);
             _proto.template set<proto::kFCore>(_X);
@@ -205,27 +330,13 @@ namespace zdf
         }
 
       private:
-        // Generate the minimal filter
-        static void h(const unsigned short n, const unsigned short kappa, const unsigned short mu, const float& lambda, float (&wkg)[N*wkx::N], float (&out)[N]) {
-            const auto gamma = (lambda*((mu+n+1)*nCr(kappa+mu+2*n+1, kappa+n))) / N;
-            float w =1;
-            for (unsigned short ix = 1; ix <= n; ++ix) { w *= (kappa + ix); }
-            for (unsigned short ix = 0; ix <= n; ++ix) {
-                vsPowx(N, wkg+N*wkx::kTaux, kappa+ix, wkg+N*wkx::kTauKx);
-                vsSubI(N, &ONEf, NOSTEP, wkg+N*wkx::kTaux, SINGLESTEP, wkg+N*wkx::kTauMx, SINGLESTEP);
-                vsPowx(N, wkg+N*wkx::kTauMx, mu+n-ix, wkg+N*wkx::kTauMx);
-                vsMul(N, wkg+N*wkx::kTauKx, wkg+N*wkx::kTauMx, wkg+N*wkx::kTauKx);
-                const float c = (ix%2 ? -w : w) * nCr(n, ix) * gamma;
-                saxpy(&N, &c, wkg+N*wkx::kTauKx, &SINGLESTEP, out, &SINGLESTEP);
-                w *= static_cast<float>(mu+n-ix) / (kappa + ix+1); 
-            }
-        }
-
         Proto<T> _proto;
         float _X[N];
         float _fir[N*kF];
         float _filtered[kF];
         MKL_INT _hx;
+        const MKL_INT _R;
+        MKL_INT _rx;
     };
 
 } // namespace zdf
\ No newline at end of file
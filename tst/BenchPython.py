@@ -0,0 +1,90 @@
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+from os.path import abspath, dirname, join, normpath
+
+import numpy as np
+
+import zdf
+
+coresuffix = ".zdft"
+updisuffix = ".zdfi"
+outpsuffix = ".zdfo"
+
+byteorder = '>' if (sys.byteorder == 'big') else '<'
+
+if len(sys.argv) != 4:
+    print(f"Argument list Error. Must be {sys.argv[0]} /path/to/zdf/executable /existing/zdf/dir encodingInteger", file=sys.stderr)
+    sys.exit(1)
+
+executable = abspath(sys.argv[1])
+enc = int(sys.argv[3])
+# The executable reads from ./dat/, so the round-trip runs in a scratch dat directory holding a copy of the .zdft,
+# leaving the files in the given directory untouched
+zdfdir = join(tempfile.mkdtemp(), "dat")
+os.mkdir(zdfdir)
+shutil.copy(join(normpath(sys.argv[2]), str(enc)+coresuffix), zdfdir)
+
+U = 256     # Number of observations the executable filters per run (zdf.update<256>)
+R = 50      # Number of timed repetitions
+
+f = zdf.ZDF(enc, zdfdir)
+kF = f.kF
+y = np.cumsum(np.random.normal(scale=0.01, size=U)).astype(np.float32)
+
+
+def roundtrip():
+    """ The current research loop: write a .zdfi, run the executable, parse the .zdfo record by record """
+    with open(join(zdfdir, str(enc)+updisuffix), 'wb') as fi:
+        fi.write(struct.pack(byteorder+f'{U}f', *y))
+    subprocess.run([executable, "-t", "1", "-z", str(enc)], cwd=dirname(zdfdir), check=True)
+    derivFmt = byteorder+f'{kF}f'
+    recordSize = struct.calcsize(derivFmt)
+    rows = []
+    with open(join(zdfdir, str(enc)+outpsuffix), 'rb') as fo:
+        while True:
+            derivx = fo.read(recordSize)
+            if not derivx:
+                break
+            rows.append(struct.unpack(derivFmt, derivx))
+    return np.array(rows, dtype=np.float32)
+
+
+def extension():
+    """ Filtering the same observations from the same initialization through the extension """
+    return zdf.ZDF(enc, zdfdir).filter(y)
+
+
+def extensionFilterOnly(filters, out):
+    """ As above but with the filter constructed and the output allocated up front """
+    filters.pop().filter(y, out=out)
+
+
+print(f"Max abs difference: {np.max(np.abs(roundtrip() - extension()))}")
+
+start = time.perf_counter()
+for _ in range(R):
+    roundtrip()
+tr = (time.perf_counter() - start) / R
+
+start = time.perf_counter()
+for _ in range(R):
+    extension()
+te = (time.perf_counter() - start) / R
+
+filters = [zdf.ZDF(enc, zdfdir) for _ in range(R)]
+out = np.empty((U, kF), dtype=np.float32)
+start = time.perf_counter()
+for _ in range(R):
+    extensionFilterOnly(filters, out)
+tf = (time.perf_counter() - start) / R
+
+print(f"File round-trip: {1e3*tr:.3f} ms")
+print(f"Extension incl. construction: {1e3*te:.3f} ms (x{tr/te:.1f})")
+print(f"Extension filtering only: {1e3*tf:.3f} ms (x{tr/tf:.1f})")
+
+shutil.rmtree(dirname(zdfdir))
@@ -11,8 +11,8 @@ updisuffix = ".zdfi"
 print(f"The system's byte order is: {sys.byteorder}")
 byteorder = '>' if (sys.byteorder == 'big') else '<'
 
-if len(sys.argv) < 1 or len(sys.argv) > 3:
-    print(f"Argument list Error. Must be {sys.argv[0]} {{/desired/zdf/dir encodingInteger, /path/to/output.zdfo}}", file=sys.stderr)
+if len(sys.argv) not in (2, 3, 5):
+    print(f"Argument list Error. Must be {sys.argv[0]} {{/desired/zdf/dir encodingInteger [slowEncodingInteger decimation], /path/to/output.zdfo}}", file=sys.stderr)
     sys.exit(1) 
 
 if len(sys.argv) == 2:
@@ -54,4 +54,16 @@ with open(updifile, 'wb') as f:
     yFmt = f'{U}f'
     f.write(struct.pack(byteorder+yFmt, *yr[N:].flatten('F')))
 
+if len(sys.argv) == 5:  # Generate the .zdft of the slow filter in a Cascade decimated by R
+    slowfile = join(sys.argv[1], sys.argv[3]+coresuffix)
+    NS = int(sys.argv[3]) & 0x0000FFFF     # Length of the slow filter
+    R = int(sys.argv[4])
+    # The noise-free series stands in for the fast filter's zeroth derivative, sampled every R observations up to
+    # the last initialization value
+    ts = tvec[N-1] - (tvec[1]-tvec[0])*R*np.arange(NS-1, -1, -1)
+    ys = -np.exp(-rate*ts)*(np.cos(ts) + rate*np.sin(ts)) / (1+rate*rate) + C
+    with open(slowfile, 'wb') as f:
+        yFmt = f'{NS}f'
+        f.write(struct.pack(byteorder+yFmt, *ys.flatten('F')))
+
 